@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "funcs.h"
 
 /* ========== Helper Functions ========== */
@@ -428,6 +432,1371 @@ int get_color_input(const char* prompt, ColorCode* color, int band_num, int tota
     return 1;
 }
 
+/* ========== Batch Report Functions ========== */
+
+/* Tolerances and temperature coefficients in the order used by packed keys */
+static const double key_tolerances[] = { 0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0 };
+static const int key_tempcos[] = { 0, 5, 10, 15, 25, 50, 100 };
+
+#define NUM_KEY_TOLERANCES ((int)(sizeof(key_tolerances) / sizeof(key_tolerances[0])))
+#define NUM_KEY_TEMPCOS    ((int)(sizeof(key_tempcos) / sizeof(key_tempcos[0])))
+#define KEY_BITS 56        /* 48 bits of centiohms + 8 bits of tolerance/tempco */
+
+/* Decode one line of a parts file.
+ * Returns 1 if decoded, 0 if the line is invalid and -1 if it is blank. */
+int decode_part_line(const char* line, ResistorInfo* info) {
+    char buffer[256];
+    ColorCode bands[6];
+    int count = 0;
+    int i;
+    char* p;
+    
+    strncpy(buffer, line, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    buffer[strcspn(buffer, "#\r\n")] = '\0';  /* Strip comment and newline */
+    
+    /* Split into color names (no strtok, so the function stays reentrant) */
+    p = buffer;
+    while(*p) {
+        char* start;
+        
+        while(*p == ' ' || *p == '\t' || *p == ',') p++;
+        if(*p == '\0') break;
+        
+        start = p;
+        while(*p && *p != ' ' && *p != '\t' && *p != ',') p++;
+        if(*p) *p++ = '\0';
+        
+        if(count == 6) return 0;  /* Too many bands */
+        bands[count] = get_color_from_input(start);
+        if(bands[count] == INVALID_COLOR) return 0;
+        count++;
+    }
+    
+    if(count == 0) return -1;
+    if(count < 4) return 0;
+    
+    /* Apply the same band rules as the interactive decoders */
+    for(i = 0; i < count; i++) {
+        if(!validate_color_for_band(bands[i], i + 1, count)) return 0;
+    }
+    
+    switch(count) {
+        case 4:
+            *info = decode_4band_resistor(bands[0], bands[1], bands[2], bands[3]);
+            break;
+        case 5:
+            *info = decode_5band_resistor(bands[0], bands[1], bands[2], bands[3], bands[4]);
+            break;
+        case 6:
+            *info = decode_6band_resistor(bands[0], bands[1], bands[2], bands[3],
+                                          bands[4], bands[5]);
+            break;
+        default:
+            return 0;
+    }
+    
+    return info->resistance >= 0;
+}
+
+/* Pack a decoded resistor into an integer key.
+ * Bits 8+ hold the resistance in centiohms, bits 4-7 the tolerance index and
+ * bits 0-3 the tempco index, so sorting keys sorts by value first. */
+unsigned long long pack_resistor_key(ResistorInfo info) {
+    unsigned long long centiohms = (unsigned long long)llround(info.resistance * 100.0);
+    int tol_index = 0, tc_index = 0;
+    int i;
+    
+    for(i = 0; i < NUM_KEY_TOLERANCES; i++) {
+        if(fabs(info.tolerance - key_tolerances[i]) < 1e-9) tol_index = i;
+    }
+    for(i = 0; i < NUM_KEY_TEMPCOS; i++) {
+        if(info.temp_coefficient == key_tempcos[i]) tc_index = i;
+    }
+    
+    return (centiohms << 8) | ((unsigned long long)tol_index << 4) | (unsigned long long)tc_index;
+}
+
+/* Unpack a key made by pack_resistor_key() (the band count is not stored) */
+ResistorInfo unpack_resistor_key(unsigned long long key) {
+    ResistorInfo info;
+    
+    info.resistance = (double)(key >> 8) / 100.0;
+    info.tolerance = key_tolerances[(key >> 4) & 0x0F];
+    info.temp_coefficient = key_tempcos[key & 0x0F];
+    info.num_bands = (info.temp_coefficient > 0) ? 6 : 0;
+    return info;
+}
+
+/* Decade of a packed key: 0 for 0.01-0.1 Ω up to NUM_DECADES-1 for
+ * 100 GΩ-1 TΩ, or -1 for 0 Ω, which belongs to no decade */
+int get_decade_index(unsigned long long key) {
+    unsigned long long centiohms = key >> 8;
+    int index = 0;
+    
+    if(centiohms == 0) return -1;  /* Not produced by validated bands */
+    
+    while(centiohms >= 10 && index < NUM_DECADES - 1) {
+        centiohms /= 10;
+        index++;
+    }
+    return index;
+}
+
+/* Sort groups by key with an LSD radix sort, 8 bits per pass.
+ * scratch must hold n groups. Passes where every key shares the same byte
+ * are skipped, which is common since most keys use few high bits. */
+void radix_sort_groups(PartGroup* groups, PartGroup* scratch, size_t n) {
+    size_t counts[256];
+    PartGroup* src = groups;
+    PartGroup* dst = scratch;
+    PartGroup* tmp;
+    int shift, b;
+    size_t i, offset;
+    
+    for(shift = 0; shift < KEY_BITS; shift += 8) {
+        memset(counts, 0, sizeof(counts));
+        for(i = 0; i < n; i++) {
+            counts[(src[i].key >> shift) & 0xFF]++;
+        }
+        if(n == 0 || counts[(src[0].key >> shift) & 0xFF] == n) {
+            continue;  /* Nothing to reorder on this byte */
+        }
+        
+        offset = 0;
+        for(b = 0; b < 256; b++) {
+            size_t c = counts[b];
+            counts[b] = offset;
+            offset += c;
+        }
+        for(i = 0; i < n; i++) {
+            dst[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    
+    if(src != groups) {
+        memcpy(groups, src, n * sizeof(PartGroup));
+    }
+}
+
+/* Hash a packed key into a slot index for a table of 'capacity' slots */
+static size_t hash_key(unsigned long long key, size_t capacity) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+/* Set up an empty report. Returns 0 if out of memory. */
+int report_init(PartReport* report) {
+    memset(report, 0, sizeof(*report));
+    report->capacity = 1024;
+    report->slots = calloc(report->capacity, sizeof(PartGroup));
+    return report->slots != NULL;
+}
+
+/* Double the hash table size and re-insert every group */
+static int report_grow(PartReport* report) {
+    size_t new_capacity = report->capacity * 2;
+    PartGroup* new_slots = calloc(new_capacity, sizeof(PartGroup));
+    size_t i, j;
+    
+    if(new_slots == NULL) return 0;
+    
+    for(i = 0; i < report->capacity; i++) {
+        if(report->slots[i].count == 0) continue;
+        j = hash_key(report->slots[i].key, new_capacity);
+        while(new_slots[j].count != 0) {
+            j = (j + 1) & (new_capacity - 1);
+        }
+        new_slots[j] = report->slots[i];
+    }
+    
+    free(report->slots);
+    report->slots = new_slots;
+    report->capacity = new_capacity;
+    return 1;
+}
+
+static int report_add_count(PartReport* report, unsigned long long key, unsigned long count);
+
+/* Count one decoded part. Memory only grows with the number of distinct
+ * parts, so streams of any length fit. Returns 0 if out of memory. */
+int report_add(PartReport* report, ResistorInfo info) {
+    return report_add_count(report, pack_resistor_key(info), 1);
+}
+
+/* Add 'count' parts with the same key */
+static int report_add_count(PartReport* report, unsigned long long key, unsigned long count) {
+    size_t i;
+    int decade;
+    
+    /* Keep the table at most 70% full so probe chains stay short */
+    if((report->used + 1) * 10 > report->capacity * 7) {
+        if(!report_grow(report)) return 0;
+    }
+    
+    i = hash_key(key, report->capacity);
+    while(report->slots[i].count != 0 && report->slots[i].key != key) {
+        i = (i + 1) & (report->capacity - 1);
+    }
+    if(report->slots[i].count == 0) {
+        report->slots[i].key = key;
+        report->used++;
+    }
+    report->slots[i].count += count;
+    
+    report->total_parts += count;
+    decade = get_decade_index(key);
+    if(decade >= 0) report->decade_counts[decade] += count;
+    return 1;
+}
+
+/* Add every part counted in 'from' to 'into', e.g. to combine the tables of
+ * several workers. Returns 0 if out of memory. */
+int report_merge(PartReport* into, const PartReport* from) {
+    size_t i;
+    
+    for(i = 0; i < from->capacity; i++) {
+        if(from->slots[i].count == 0) continue;
+        if(!report_add_count(into, from->slots[i].key, from->slots[i].count)) return 0;
+    }
+    into->invalid_lines += from->invalid_lines;
+    return 1;
+}
+
+/* qsort comparator: highest count first, then lowest key */
+static int compare_group_count(const void* a, const void* b) {
+    const PartGroup* ga = (const PartGroup*)a;
+    const PartGroup* gb = (const PartGroup*)b;
+    
+    if(ga->count != gb->count) return (ga->count < gb->count) ? 1 : -1;
+    if(ga->key != gb->key) return (ga->key < gb->key) ? -1 : 1;
+    return 0;
+}
+
+/* Sort the distinct parts and pick the top_n most common.
+ * Returns 0 if out of memory. */
+int finish_part_report(PartReport* report, size_t top_n) {
+    PartGroup* scratch;
+    size_t i, n = 0;
+    
+    report->groups = malloc((report->used + 1) * sizeof(PartGroup));
+    scratch = malloc((report->used + 1) * sizeof(PartGroup));
+    if(report->groups == NULL || scratch == NULL) {
+        free(scratch);
+        return 0;
+    }
+    
+    for(i = 0; i < report->capacity; i++) {
+        if(report->slots[i].count != 0) {
+            report->groups[n++] = report->slots[i];
+        }
+    }
+    report->num_groups = n;
+    radix_sort_groups(report->groups, scratch, n);
+    
+    /* Reuse the scratch buffer for the top list */
+    memcpy(scratch, report->groups, n * sizeof(PartGroup));
+    qsort(scratch, n, sizeof(PartGroup), compare_group_count);
+    report->top = scratch;
+    report->num_top = (top_n < n) ? top_n : n;
+    return 1;
+}
+
+/* Release all memory owned by a report */
+void report_free(PartReport* report) {
+    free(report->slots);
+    free(report->groups);
+    free(report->top);
+    memset(report, 0, sizeof(*report));
+}
+
+/* Write one CSV row for a group */
+static void write_group_csv(FILE* out, const char* section, PartGroup group) {
+    ResistorInfo info = unpack_resistor_key(group.key);
+    
+    fprintf(out, "%s,%.2f,%.2f,%d,,%lu\n", section, info.resistance,
+            info.tolerance, info.temp_coefficient, group.count);
+}
+
+/* Write a report as CSV. The first column says which part of the report
+ * a row belongs to ("summary", "part", "top" or "decade"); the label column
+ * names summary totals and gives the lower bound of each decade in ohms. */
+void write_report_csv(FILE* out, const PartReport* report) {
+    size_t i;
+    int d;
+    
+    fprintf(out, "section,resistance_ohms,tolerance_pct,tempco_ppm,label,count\n");
+    fprintf(out, "summary,,,,total_parts,%llu\n", report->total_parts);
+    fprintf(out, "summary,,,,invalid_lines,%llu\n", report->invalid_lines);
+    fprintf(out, "summary,,,,distinct_parts,%lu\n", (unsigned long)report->num_groups);
+    
+    for(i = 0; i < report->num_groups; i++) {
+        write_group_csv(out, "part", report->groups[i]);
+    }
+    for(i = 0; i < report->num_top; i++) {
+        write_group_csv(out, "top", report->top[i]);
+    }
+    for(d = 0; d < NUM_DECADES; d++) {
+        fprintf(out, "decade,,,,1e%d,%llu\n", d - 2, report->decade_counts[d]);
+    }
+}
+
+/* Write a JSON array of groups */
+static void write_groups_json(FILE* out, const PartGroup* groups, size_t n) {
+    size_t i;
+    
+    fprintf(out, "[");
+    for(i = 0; i < n; i++) {
+        ResistorInfo info = unpack_resistor_key(groups[i].key);
+        fprintf(out, "%s\n    {\"resistance_ohms\": %.2f, \"tolerance_pct\": %.2f, "
+                "\"tempco_ppm\": %d, \"count\": %lu}",
+                (i > 0) ? "," : "", info.resistance, info.tolerance,
+                info.temp_coefficient, groups[i].count);
+    }
+    fprintf(out, "%s]", (n > 0) ? "\n  " : "");
+}
+
+/* Write a report as a JSON object */
+void write_report_json(FILE* out, const PartReport* report) {
+    int d;
+    
+    fprintf(out, "{\n");
+    fprintf(out, "  \"total_parts\": %llu,\n", report->total_parts);
+    fprintf(out, "  \"invalid_lines\": %llu,\n", report->invalid_lines);
+    fprintf(out, "  \"distinct_parts\": %lu,\n", (unsigned long)report->num_groups);
+    fprintf(out, "  \"parts\": ");
+    write_groups_json(out, report->groups, report->num_groups);
+    fprintf(out, ",\n  \"top\": ");
+    write_groups_json(out, report->top, report->num_top);
+    fprintf(out, ",\n  \"decades\": [");
+    for(d = 0; d < NUM_DECADES; d++) {
+        fprintf(out, "%s\n    {\"decade_ohms\": 1e%d, \"count\": %llu}",
+                (d > 0) ? "," : "", d - 2, report->decade_counts[d]);
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+/* ========== Arena Functions ========== */
+
+#define ARENA_ALIGNMENT 16  /* Enough for any record type used here */
+
+/* Set up an empty arena. No memory is taken until the first allocation. */
+void arena_init(Arena* arena, size_t block_size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->block_size = block_size;
+}
+
+/* Return the offset of the next aligned allocation in a block */
+static size_t arena_aligned_offset(const ArenaBlock* block) {
+    uintptr_t address = (uintptr_t)(block->data + block->used);
+    uintptr_t aligned = (address + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1);
+    return block->used + (size_t)(aligned - address);
+}
+
+/* Allocate memory that stays valid until the next arena_reset().
+ * Blocks kept from earlier batches are reused before asking malloc() for
+ * more, so once a batch has been seen, batches of the same shape need no
+ * heap allocations. Returns NULL if out of memory. */
+void* arena_alloc(Arena* arena, size_t size) {
+    ArenaBlock* block = arena->current;
+    size_t offset;
+    
+    /* Move on to the next kept block until one has room */
+    while(block != NULL) {
+        offset = arena_aligned_offset(block);
+        if(offset + size <= block->size) break;
+        if(block->next == NULL || block->next->size < size + ARENA_ALIGNMENT) {
+            block = NULL;
+            break;
+        }
+        block = block->next;
+        block->used = 0;
+        arena->current = block;
+    }
+    
+    if(block == NULL) {
+        size_t block_size = arena->block_size;
+        if(block_size < size + ARENA_ALIGNMENT) block_size = size + ARENA_ALIGNMENT;
+        
+        block = malloc(sizeof(ArenaBlock) + block_size);
+        if(block == NULL) return NULL;
+        block->size = block_size;
+        block->used = 0;
+        arena->heap_allocations++;
+        arena->reserved_bytes += block_size;
+        
+        /* Insert after the current block so kept blocks stay in the chain */
+        if(arena->current == NULL) {
+            block->next = arena->first;
+            arena->first = block;
+        } else {
+            block->next = arena->current->next;
+            arena->current->next = block;
+        }
+        arena->current = block;
+        offset = arena_aligned_offset(block);
+    }
+    
+    arena->bytes_in_use += (offset - block->used) + size;
+    if(arena->bytes_in_use > arena->peak_bytes) arena->peak_bytes = arena->bytes_in_use;
+    arena->allocations++;
+    
+    block->used = offset + size;
+    return block->data + offset;
+}
+
+/* Release everything allocated since the last reset in O(1).
+ * Blocks are kept; each one is cleared when allocation reaches it. */
+void arena_reset(Arena* arena) {
+    arena->current = arena->first;
+    if(arena->current != NULL) arena->current->used = 0;
+    arena->bytes_in_use = 0;
+    arena->resets++;
+}
+
+/* Return every block to the heap */
+void arena_free(Arena* arena) {
+    ArenaBlock* block = arena->first;
+    
+    while(block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = arena->current = NULL;
+    arena->bytes_in_use = 0;
+    arena->reserved_bytes = 0;
+}
+
+/* ========== Export Functions ========== */
+
+#define WRITER_BUFFER_SIZE (1024 * 1024)  /* Text is written in 1 MiB chunks */
+#define MAX_ROW_LENGTH 256                 /* Longest formatted row */
+#define COLUMNAR_VERSION 1
+
+/* Allocate room for 'capacity' parts from an arena, valid until the arena
+ * is reset. Returns 0 if out of memory. */
+int part_batch_init(PartBatch* batch, Arena* arena, size_t capacity) {
+    batch->parts = arena_alloc(arena, capacity * sizeof(ResistorInfo));
+    batch->count = 0;
+    batch->capacity = capacity;
+    batch->invalid_lines = 0;
+    return batch->parts != NULL;
+}
+
+/* Write out everything held in the text buffer */
+static int writer_flush(PartWriter* writer) {
+    if(writer->length > 0 &&
+       fwrite(writer->buffer, 1, writer->length, writer->out) != writer->length) {
+        return 0;
+    }
+    writer->length = 0;
+    return 1;
+}
+
+/* Make sure at least MAX_ROW_LENGTH bytes are free in the text buffer */
+static int writer_reserve_row(PartWriter* writer) {
+    if(writer->size - writer->length < MAX_ROW_LENGTH) {
+        return writer_flush(writer);
+    }
+    return 1;
+}
+
+/* Start writing parts in the given format and write any file header.
+ * Returns 0 on failure. */
+int part_writer_open(PartWriter* writer, FILE* out, ExportFormat format, size_t batch_capacity) {
+    unsigned int version = COLUMNAR_VERSION;
+    
+    memset(writer, 0, sizeof(*writer));
+    writer->out = out;
+    writer->format = format;
+    
+    if(format == EXPORT_COLUMNAR) {
+        /* Four double columns share one allocation, tempcos have their own */
+        writer->columns = malloc(4 * batch_capacity * sizeof(double));
+        writer->tempcos = malloc(batch_capacity * sizeof(int));
+        writer->column_capacity = batch_capacity;
+        if(writer->columns == NULL || writer->tempcos == NULL) {
+            part_writer_close(writer);
+            return 0;
+        }
+        return fwrite("RCOL", 1, 4, out) == 4 &&
+               fwrite(&version, sizeof(version), 1, out) == 1;
+    }
+    
+    writer->buffer = malloc(WRITER_BUFFER_SIZE);
+    writer->size = WRITER_BUFFER_SIZE;
+    if(writer->buffer == NULL) {
+        return 0;
+    }
+    
+    if(format == EXPORT_CSV) {
+        writer->length = (size_t)snprintf(writer->buffer, writer->size,
+            "resistance_ohms,tolerance_pct,tempco_ppm,min_ohms,max_ohms,num_bands\n");
+    }
+    return 1;
+}
+
+/* Write one batch as a columnar block */
+static int write_batch_columnar(PartWriter* writer, const PartBatch* batch) {
+    unsigned int count = (unsigned int)batch->count;
+    double* resistance = writer->columns;
+    double* tolerance = resistance + count;
+    double* minimum = tolerance + count;
+    double* maximum = minimum + count;
+    size_t i;
+    
+    if(batch->count > writer->column_capacity) {
+        return 0;
+    }
+    
+    for(i = 0; i < count; i++) {
+        const ResistorInfo* p = &batch->parts[i];
+        resistance[i] = p->resistance;
+        tolerance[i] = p->tolerance;
+        writer->tempcos[i] = p->temp_coefficient;
+        minimum[i] = p->resistance * (1 - p->tolerance / 100.0);
+        maximum[i] = p->resistance * (1 + p->tolerance / 100.0);
+    }
+    
+    /* Resistance/tolerance and minimum/maximum sit back to back in memory,
+     * so each block takes four large writes */
+    return fwrite(&count, sizeof(count), 1, writer->out) == 1 &&
+           fwrite(resistance, sizeof(double), 2 * (size_t)count, writer->out) == 2 * (size_t)count &&
+           fwrite(writer->tempcos, sizeof(int), count, writer->out) == count &&
+           fwrite(minimum, sizeof(double), 2 * (size_t)count, writer->out) == 2 * (size_t)count;
+}
+
+/* Write one batch of decoded parts. Returns 0 on write error. */
+int part_writer_write_batch(PartWriter* writer, const PartBatch* batch) {
+    size_t i;
+    
+    if(batch->count == 0) {
+        return 1;
+    }
+    
+    if(writer->format == EXPORT_COLUMNAR) {
+        if(!write_batch_columnar(writer, batch)) return 0;
+        writer->rows += batch->count;
+        return 1;
+    }
+    
+    for(i = 0; i < batch->count; i++) {
+        const ResistorInfo* p = &batch->parts[i];
+        double min_resistance = p->resistance * (1 - p->tolerance / 100.0);
+        double max_resistance = p->resistance * (1 + p->tolerance / 100.0);
+        char* row;
+        size_t room;
+        int n;
+        
+        if(!writer_reserve_row(writer)) return 0;
+        row = writer->buffer + writer->length;
+        room = writer->size - writer->length;
+        
+        if(writer->format == EXPORT_CSV) {
+            n = snprintf(row, room, "%.10g,%.10g,%d,%.10g,%.10g,%d\n",
+                         p->resistance, p->tolerance, p->temp_coefficient,
+                         min_resistance, max_resistance, p->num_bands);
+        } else {
+            n = snprintf(row, room, "{\"resistance_ohms\":%.10g,\"tolerance_pct\":%.10g,"
+                         "\"tempco_ppm\":%d,\"min_ohms\":%.10g,\"max_ohms\":%.10g,"
+                         "\"num_bands\":%d}\n",
+                         p->resistance, p->tolerance, p->temp_coefficient,
+                         min_resistance, max_resistance, p->num_bands);
+        }
+        writer->length += (size_t)n;
+    }
+    
+    writer->rows += batch->count;
+    return 1;
+}
+
+/* Flush remaining output, end the file and free the writer.
+ * The FILE itself is left open. Returns 0 on write error. */
+int part_writer_close(PartWriter* writer) {
+    unsigned int end_marker = 0;
+    int ok = 1;
+    
+    if(writer->format == EXPORT_COLUMNAR) {
+        if(writer->columns != NULL && writer->tempcos != NULL) {
+            ok = fwrite(&end_marker, sizeof(end_marker), 1, writer->out) == 1;
+        }
+    } else if(writer->buffer != NULL) {
+        ok = writer_flush(writer);
+    }
+    
+    free(writer->buffer);
+    free(writer->columns);
+    free(writer->tempcos);
+    writer->buffer = NULL;
+    writer->columns = NULL;
+    writer->tempcos = NULL;
+    return ok && fflush(writer->out) == 0;
+}
+
+/* ========== Pipeline Functions ========== */
+
+#define PIPELINE_SLOTS 4  /* Chunks in flight between the three stages */
+#define REPORT_MAX_WORKERS 8                    /* Threads aggregating a report */
+#define MAX_SLOTS (REPORT_MAX_WORKERS + 2)      /* Room for the largest use */
+#define SLOT_BATCHES (PIPELINE_MAX_PARTS / PIPELINE_BATCH_PARTS + 1)
+/* Arena blocks hold four batches, so a chunk of many parts spans blocks */
+#define PIPELINE_ARENA_BLOCK (4 * (PIPELINE_BATCH_PARTS * sizeof(ResistorInfo) + ARENA_ALIGNMENT))
+
+/* What a slot holds; each stage moves a slot on to the next state */
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_READ,
+    SLOT_DECODED,
+    SLOT_BUSY                 /* Taken by a report worker */
+} SlotState;
+
+/* One chunk of the parts file on its way through the pipeline */
+typedef struct {
+    SlotState state;
+    char* data;               /* Raw text, PIPELINE_CHUNK_SIZE + 1 bytes */
+    size_t length;            /* Bytes of whole lines in data */
+    int last;                 /* Set on the final chunk of the file */
+    Arena arena;              /* Holds the decoded parts of this chunk */
+    PartBatch batches[SLOT_BATCHES];  /* Decoded parts, in file order */
+    size_t num_batches;
+} PipelineSlot;
+
+/* Shared state of one pipeline run */
+typedef struct {
+    FILE* in;
+    PartWriter* writer;
+    PipelineStats* stats;
+    PipelineSlot slots[MAX_SLOTS];
+    int num_slots;            /* Slots in use */
+    char* carry;              /* Partial last line of the previous chunk */
+    size_t carry_length;
+    int failed;               /* Set by any stage to stop the others */
+    int input_done;           /* Set once the last chunk has been read */
+    pthread_mutex_t lock;
+    pthread_cond_t changed;   /* Signalled whenever a slot changes state */
+} Pipeline;
+
+/* Current time in milliseconds */
+static double now_ms(void) {
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* Read stage: fill a slot with whole lines, keeping any partial last line
+ * for the next chunk. Returns 0 on read error. */
+static int pipeline_read(Pipeline* pipeline, PipelineSlot* slot) {
+    size_t total, n, end;
+    
+    memcpy(slot->data, pipeline->carry, pipeline->carry_length);
+    n = fread(slot->data + pipeline->carry_length, 1,
+              PIPELINE_CHUNK_SIZE - pipeline->carry_length, pipeline->in);
+    if(ferror(pipeline->in)) return 0;
+    
+    total = pipeline->carry_length + n;
+    pipeline->stats->bytes_read += n;
+    pipeline->stats->chunks++;
+    slot->last = (total < PIPELINE_CHUNK_SIZE);  /* Short read means end of file */
+    
+    /* Cut after the last newline; a chunk with none is taken whole */
+    end = total;
+    if(!slot->last) {
+        while(end > 0 && slot->data[end - 1] != '\n') end--;
+        if(end == 0) end = total;
+    }
+    
+    pipeline->carry_length = total - end;
+    memcpy(pipeline->carry, slot->data + end, pipeline->carry_length);
+    slot->length = end;
+    return 1;
+}
+
+/* Return the next line of a chunk, NUL-terminated in place, and move the
+ * cursor past it. Returns NULL at the end of the chunk. */
+static char* next_chunk_line(char** cursor, char* end) {
+    char* line = *cursor;
+    char* newline;
+    
+    if(line >= end) return NULL;
+    newline = memchr(line, '\n', (size_t)(end - line));
+    if(newline != NULL) {
+        *newline = '\0';
+        *cursor = newline + 1;
+    } else {
+        *cursor = end;
+    }
+    return line;
+}
+
+/* Decode stage: decode every line of a chunk into batches held in the
+ * slot's arena, taking a new batch from the arena each time one fills up.
+ * Returns 0 if out of memory or the slot has no batches left. */
+static int pipeline_decode(Pipeline* pipeline, PipelineSlot* slot) {
+    char* cursor = slot->data;
+    char* end = slot->data + slot->length;
+    char* line;
+    PartBatch* batch = NULL;
+    size_t i;
+    int result;
+    
+    arena_reset(&slot->arena);
+    slot->num_batches = 0;
+    
+    *end = '\0';
+    while((line = next_chunk_line(&cursor, end)) != NULL) {
+        if(batch == NULL || batch->count == batch->capacity) {
+            if(slot->num_batches == SLOT_BATCHES) return 0;
+            batch = &slot->batches[slot->num_batches];
+            if(!part_batch_init(batch, &slot->arena, PIPELINE_BATCH_PARTS)) return 0;
+            slot->num_batches++;
+        }
+        result = decode_part_line(line, &batch->parts[batch->count]);
+        if(result == 1) {
+            batch->count++;
+        } else if(result == 0) {
+            batch->invalid_lines++;
+        }
+    }
+    
+    for(i = 0; i < slot->num_batches; i++) {
+        pipeline->stats->parts += slot->batches[i].count;
+        pipeline->stats->invalid_lines += slot->batches[i].invalid_lines;
+    }
+    return 1;
+}
+
+/* Write stage: format and write the decoded batches. Returns 0 on write error. */
+static int pipeline_write(Pipeline* pipeline, PipelineSlot* slot) {
+    size_t i;
+    
+    for(i = 0; i < slot->num_batches; i++) {
+        if(!part_writer_write_batch(pipeline->writer, &slot->batches[i])) return 0;
+    }
+    return 1;
+}
+
+/* Run stages first..last (in order) over every chunk, waiting for each slot
+ * to reach the state the first of them works on. A single thread can run
+ * any contiguous run of stages, so fewer threads still finish the job. */
+static void run_pipeline_stages(Pipeline* pipeline, PipelineStage first, PipelineStage last_stage) {
+    static const SlotState wait_for[NUM_STAGES] = { SLOT_FREE, SLOT_READ, SLOT_DECODED };
+    static const SlotState hand_on[NUM_STAGES] = { SLOT_READ, SLOT_DECODED, SLOT_FREE };
+    PipelineStats* stats = pipeline->stats;
+    PipelineSlot* slot;
+    size_t index;
+    double start;
+    int stage, ok, last, failed;
+    
+    for(index = 0; ; index++) {
+        slot = &pipeline->slots[index % pipeline->num_slots];
+        
+        start = now_ms();
+        pthread_mutex_lock(&pipeline->lock);
+        while(slot->state != wait_for[first] && !pipeline->failed) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+        failed = pipeline->failed;
+        pthread_mutex_unlock(&pipeline->lock);
+        stats->wait_ms[first] += now_ms() - start;
+        if(failed) break;
+        
+        ok = 1;
+        for(stage = first; ok && stage <= (int)last_stage; stage++) {
+            start = now_ms();
+            switch(stage) {
+                case STAGE_READ:   ok = pipeline_read(pipeline, slot);   break;
+                case STAGE_DECODE: ok = pipeline_decode(pipeline, slot); break;
+                default:           ok = pipeline_write(pipeline, slot);  break;
+            }
+            stats->busy_ms[stage] += now_ms() - start;
+        }
+        last = slot->last;  /* Read before the slot is handed on and reused */
+        
+        pthread_mutex_lock(&pipeline->lock);
+        if(ok) {
+            slot->state = hand_on[last_stage];
+        } else {
+            pipeline->failed = 1;
+        }
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->lock);
+        
+        if(!ok || last) break;
+    }
+}
+
+/* Thread entry points for the read and write stages */
+static void* pipeline_reader(void* arg) {
+    run_pipeline_stages((Pipeline*)arg, STAGE_READ, STAGE_READ);
+    return NULL;
+}
+
+static void* pipeline_writer(void* arg) {
+    run_pipeline_stages((Pipeline*)arg, STAGE_WRITE, STAGE_WRITE);
+    return NULL;
+}
+
+/* Decode a parts file and write the results, overlapping reading of the next
+ * chunk, decoding of the current one and writing of the previous one on
+ * three threads. If a thread cannot be started the calling thread takes on
+ * its stages as well, down to running all three in turn. The writer must
+ * have been opened with a batch capacity of at least PIPELINE_BATCH_PARTS.
+ * Returns 0 on error or out of memory. */
+int run_export_pipeline(FILE* in, PartWriter* writer, PipelineStats* stats) {
+    Pipeline pipeline;
+    pthread_t reader, writer_thread;
+    double start = now_ms();
+    int ok = 1, i;
+    
+    memset(stats, 0, sizeof(*stats));
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.in = in;
+    pipeline.writer = writer;
+    pipeline.stats = stats;
+    pipeline.num_slots = PIPELINE_SLOTS;
+    
+    pipeline.carry = malloc(PIPELINE_CHUNK_SIZE);
+    for(i = 0; i < PIPELINE_SLOTS; i++) {
+        pipeline.slots[i].data = malloc(PIPELINE_CHUNK_SIZE + 1);
+        arena_init(&pipeline.slots[i].arena, PIPELINE_ARENA_BLOCK);
+        if(pipeline.slots[i].data == NULL) ok = 0;
+    }
+    
+    if(ok && pipeline.carry != NULL) {
+        int have_reader, have_writer;
+        
+        pthread_mutex_init(&pipeline.lock, NULL);
+        pthread_cond_init(&pipeline.changed, NULL);
+        
+        have_reader = (pthread_create(&reader, NULL, pipeline_reader, &pipeline) == 0);
+        have_writer = have_reader &&
+                      (pthread_create(&writer_thread, NULL, pipeline_writer, &pipeline) == 0);
+        stats->threads = 1 + have_reader + have_writer;
+        
+        /* The calling thread decodes, plus whatever stages have no thread */
+        run_pipeline_stages(&pipeline, have_reader ? STAGE_DECODE : STAGE_READ,
+                            have_writer ? STAGE_DECODE : STAGE_WRITE);
+        if(have_reader) pthread_join(reader, NULL);
+        if(have_writer) pthread_join(writer_thread, NULL);
+        ok = !pipeline.failed;
+        
+        pthread_cond_destroy(&pipeline.changed);
+        pthread_mutex_destroy(&pipeline.lock);
+    } else {
+        ok = 0;
+    }
+    
+    for(i = 0; i < PIPELINE_SLOTS; i++) {
+        stats->arena_allocations += pipeline.slots[i].arena.allocations;
+        stats->arena_resets += pipeline.slots[i].arena.resets;
+        stats->heap_allocations += pipeline.slots[i].arena.heap_allocations;
+        stats->reserved_arena_bytes += pipeline.slots[i].arena.reserved_bytes;
+        if(pipeline.slots[i].arena.peak_bytes > stats->peak_arena_bytes) {
+            stats->peak_arena_bytes = pipeline.slots[i].arena.peak_bytes;
+        }
+        arena_free(&pipeline.slots[i].arena);
+        free(pipeline.slots[i].data);
+    }
+    free(pipeline.carry);
+    
+    stats->wall_ms = now_ms() - start;
+    return ok;
+}
+
+/* Print stage timings, showing which stage limits throughput */
+void print_pipeline_stats(const PipelineStats* stats) {
+    static const char* stage_names[NUM_STAGES] = { "Read", "Decode", "Write" };
+    int stage, busiest = 0;
+    double seconds = stats->wall_ms / 1000.0;
+    
+    printf("\nPipeline (%d thread(s) for %d stages):\n", stats->threads, NUM_STAGES);
+    printf("  Stage    Busy (ms)   Wait (ms)   Utilisation\n");
+    printf("  -------  ----------  ----------  -----------\n");
+    for(stage = 0; stage < NUM_STAGES; stage++) {
+        double utilisation = (stats->wall_ms > 0) ? stats->busy_ms[stage] / stats->wall_ms * 100.0 : 0;
+        printf("  %-7s  %10.2f  %10.2f  %10.1f%%\n", stage_names[stage],
+               stats->busy_ms[stage], stats->wait_ms[stage], utilisation);
+        if(stats->busy_ms[stage] > stats->busy_ms[busiest]) busiest = stage;
+    }
+    
+    printf("\nLimiting stage: %s\n", stage_names[busiest]);
+    printf("Wall time:      %.2f ms for %llu chunk(s)\n", stats->wall_ms, stats->chunks);
+    if(seconds > 0) {
+        printf("Throughput:     %.1f MB/s, %.0f parts/s\n",
+               stats->bytes_read / 1e6 / seconds, stats->parts / seconds);
+    }
+    
+    printf("\nArena Usage (%d slots):\n", PIPELINE_SLOTS);
+    printf("  Allocations:      %llu\n", stats->arena_allocations);
+    printf("  Resets:           %llu\n", stats->arena_resets);
+    printf("  Peak in use:      %lu bytes per chunk\n", (unsigned long)stats->peak_arena_bytes);
+    printf("  Reserved:         %lu bytes\n", (unsigned long)stats->reserved_arena_bytes);
+    printf("  Heap allocations: %llu\n", stats->heap_allocations);
+}
+
+/* ========== Parallel Report Functions ========== */
+
+/* One report worker: aggregates whole chunks into its own table */
+typedef struct {
+    Pipeline* pipeline;
+    PartReport report;
+    pthread_t thread;
+} ReportWorker;
+
+/* Number of worker threads to aggregate with: one per online CPU */
+static int report_worker_count(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    
+    if(cpus < 1) return 1;
+    if(cpus > REPORT_MAX_WORKERS) return REPORT_MAX_WORKERS;
+    return (int)cpus;
+}
+
+/* Decode every line of a chunk into a report. Returns 0 if out of memory. */
+static int report_add_chunk(PartReport* report, PipelineSlot* slot) {
+    char* cursor = slot->data;
+    char* end = slot->data + slot->length;
+    char* line;
+    ResistorInfo info;
+    int result;
+    
+    *end = '\0';
+    while((line = next_chunk_line(&cursor, end)) != NULL) {
+        result = decode_part_line(line, &info);
+        if(result == 1) {
+            if(!report_add(report, info)) return 0;
+        } else if(result == 0) {
+            report->invalid_lines++;
+        }
+    }
+    return 1;
+}
+
+/* Worker thread: take any chunk that has been read, aggregate it and hand
+ * the slot back, until the input is done and no chunks are left */
+static void* report_worker(void* arg) {
+    ReportWorker* worker = (ReportWorker*)arg;
+    Pipeline* pipeline = worker->pipeline;
+    PipelineSlot* slot;
+    int i, ok;
+    
+    for(;;) {
+        pthread_mutex_lock(&pipeline->lock);
+        for(;;) {
+            slot = NULL;
+            for(i = 0; i < pipeline->num_slots; i++) {
+                if(pipeline->slots[i].state == SLOT_READ) {
+                    slot = &pipeline->slots[i];
+                    break;
+                }
+            }
+            if(slot != NULL || pipeline->failed || pipeline->input_done) break;
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+        if(slot != NULL) slot->state = SLOT_BUSY;
+        pthread_mutex_unlock(&pipeline->lock);
+        if(slot == NULL) break;
+        
+        ok = report_add_chunk(&worker->report, slot);
+        
+        pthread_mutex_lock(&pipeline->lock);
+        slot->state = SLOT_FREE;
+        if(!ok) pipeline->failed = 1;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->lock);
+        if(!ok) break;
+    }
+    return NULL;
+}
+
+/* Decode every line of a parts file into the report. The calling thread
+ * reads chunks while one worker per CPU decodes them into its own hash
+ * table; the tables are merged at the end. If no worker can be started the
+ * calling thread aggregates each chunk itself.
+ * Returns 0 on read error or out of memory. */
+int build_part_report(FILE* in, PartReport* report) {
+    Pipeline pipeline;
+    PipelineStats stats;
+    ReportWorker workers[REPORT_MAX_WORKERS];
+    PipelineSlot* slot;
+    int num_workers = 0, wanted = report_worker_count();
+    int ok = 1, i;
+    size_t index;
+    
+    memset(&stats, 0, sizeof(stats));
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.in = in;
+    pipeline.stats = &stats;
+    pipeline.num_slots = wanted + 2;  /* Keep every worker busy while reading */
+    
+    pipeline.carry = malloc(PIPELINE_CHUNK_SIZE);
+    if(pipeline.carry == NULL) ok = 0;
+    for(i = 0; i < pipeline.num_slots; i++) {
+        pipeline.slots[i].data = malloc(PIPELINE_CHUNK_SIZE + 1);
+        if(pipeline.slots[i].data == NULL) ok = 0;
+    }
+    
+    if(ok) {
+        pthread_mutex_init(&pipeline.lock, NULL);
+        pthread_cond_init(&pipeline.changed, NULL);
+        
+        for(i = 0; i < wanted; i++) {
+            workers[num_workers].pipeline = &pipeline;
+            if(!report_init(&workers[num_workers].report)) break;
+            if(pthread_create(&workers[num_workers].thread, NULL, report_worker,
+                              &workers[num_workers]) != 0) {
+                report_free(&workers[num_workers].report);
+                break;
+            }
+            num_workers++;
+        }
+        
+        /* Read chunks in slot order and hand them to the workers */
+        for(index = 0; ; index++) {
+            slot = &pipeline.slots[index % pipeline.num_slots];
+            
+            pthread_mutex_lock(&pipeline.lock);
+            while(slot->state != SLOT_FREE && !pipeline.failed) {
+                pthread_cond_wait(&pipeline.changed, &pipeline.lock);
+            }
+            ok = !pipeline.failed;
+            pthread_mutex_unlock(&pipeline.lock);
+            if(!ok) break;
+            
+            ok = pipeline_read(&pipeline, slot);
+            if(ok && num_workers == 0) ok = report_add_chunk(report, slot);
+            
+            pthread_mutex_lock(&pipeline.lock);
+            if(!ok) {
+                pipeline.failed = 1;
+            } else if(num_workers > 0) {
+                slot->state = SLOT_READ;
+            }
+            if(!ok || slot->last) pipeline.input_done = 1;
+            pthread_cond_broadcast(&pipeline.changed);
+            pthread_mutex_unlock(&pipeline.lock);
+            
+            if(!ok || slot->last) break;
+        }
+        
+        for(i = 0; i < num_workers; i++) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        ok = !pipeline.failed;
+        for(i = 0; i < num_workers; i++) {
+            if(ok && !report_merge(report, &workers[i].report)) ok = 0;
+            report_free(&workers[i].report);
+        }
+        
+        pthread_cond_destroy(&pipeline.changed);
+        pthread_mutex_destroy(&pipeline.lock);
+    }
+    
+    for(i = 0; i < pipeline.num_slots; i++) {
+        free(pipeline.slots[i].data);
+    }
+    free(pipeline.carry);
+    return ok;
+}
+
+/* ========== Divider Search Functions ========== */
+
+/* E24 values (E6 and E12 are every 4th and 2nd entry) */
+static const int e24_values[] = {
+    10, 11, 12, 13, 15, 16, 18, 20, 22, 24, 27, 30,
+    33, 36, 39, 43, 47, 51, 56, 62, 68, 75, 82, 91
+};
+
+/* E192 values (E48 and E96 are every 4th and 2nd entry) */
+static const int e192_values[] = {
+    100, 101, 102, 104, 105, 106, 107, 109, 110, 111, 113, 114, 115, 117, 118,
+    120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135, 137, 138, 140, 142,
+    143, 145, 147, 149, 150, 152, 154, 156, 158, 160, 162, 164, 165, 167, 169,
+    172, 174, 176, 178, 180, 182, 184, 187, 189, 191, 193, 196, 198, 200, 203,
+    205, 208, 210, 213, 215, 218, 221, 223, 226, 229, 232, 234, 237, 240, 243,
+    246, 249, 252, 255, 258, 261, 264, 267, 271, 274, 277, 280, 284, 287, 291,
+    294, 298, 301, 305, 309, 312, 316, 320, 324, 328, 332, 336, 340, 344, 348,
+    352, 357, 361, 365, 370, 374, 379, 383, 388, 392, 397, 402, 407, 412, 417,
+    422, 427, 432, 437, 442, 448, 453, 459, 464, 470, 475, 481, 487, 493, 499,
+    505, 511, 517, 523, 530, 536, 542, 549, 556, 562, 569, 576, 583, 590, 597,
+    604, 612, 619, 626, 634, 642, 649, 657, 665, 673, 681, 690, 698, 706, 715,
+    723, 732, 741, 750, 759, 768, 777, 787, 796, 806, 816, 825, 835, 845, 856,
+    866, 876, 887, 898, 909, 920, 931, 942, 953, 965, 976, 988
+};
+
+/* Multiplier colors from smallest to largest */
+static const ColorCode multiplier_colors[] = {
+    SILVER, GOLD, BLACK, BROWN, RED, ORANGE, YELLOW, GREEN, BLUE, VIOLET, GREY, WHITE
+};
+
+#define NUM_MULTIPLIERS ((int)(sizeof(multiplier_colors) / sizeof(multiplier_colors[0])))
+
+/* Tempco assumed for parts without a tempco band (ppm/K), typical of
+ * carbon film parts, so unknown parts never look better than banded ones */
+#define UNKNOWN_TEMPCO 250
+
+/* Default lower limit for R1 + R2 in the divider menu (ohms) */
+#define DEFAULT_MIN_TOTAL 1000
+
+/* Build every value of an E-series across all multipliers, in ascending
+ * order, by decoding each one as a 5-band (or 6-band with a tempco) resistor.
+ * temp_coeff is NONE for parts without a tempco band.
+ * Returns 0 for an unknown series, invalid bands or out of memory. */
+int build_eseries_parts(int series, ColorCode tolerance, ColorCode temp_coeff,
+                        ResistorInfo** parts, size_t* count) {
+    const int* table;
+    int table_size, step, scale;
+    int m, v, digits;
+    size_t n = 0;
+    ResistorInfo* list;
+    
+    switch(series) {
+        case 6:   table = e24_values;  table_size = 24;  step = 4; scale = 10; break;
+        case 12:  table = e24_values;  table_size = 24;  step = 2; scale = 10; break;
+        case 24:  table = e24_values;  table_size = 24;  step = 1; scale = 10; break;
+        case 48:  table = e192_values; table_size = 192; step = 4; scale = 1;  break;
+        case 96:  table = e192_values; table_size = 192; step = 2; scale = 1;  break;
+        case 192: table = e192_values; table_size = 192; step = 1; scale = 1;  break;
+        default:  return 0;
+    }
+    
+    list = malloc((size_t)(series * NUM_MULTIPLIERS) * sizeof(ResistorInfo));
+    if(list == NULL) return 0;
+    
+    for(m = 0; m < NUM_MULTIPLIERS; m++) {
+        for(v = 0; v < table_size; v += step) {
+            digits = table[v] * scale;  /* Always three significant digits */
+            
+            if(temp_coeff == NONE) {
+                list[n] = decode_5band_resistor((ColorCode)(digits / 100),
+                                                (ColorCode)((digits / 10) % 10),
+                                                (ColorCode)(digits % 10),
+                                                multiplier_colors[m], tolerance);
+            } else {
+                list[n] = decode_6band_resistor((ColorCode)(digits / 100),
+                                                (ColorCode)((digits / 10) % 10),
+                                                (ColorCode)(digits % 10),
+                                                multiplier_colors[m], tolerance, temp_coeff);
+            }
+            
+            if(list[n].resistance < 0) {
+                free(list);
+                return 0;
+            }
+            n++;
+        }
+    }
+    
+    *parts = list;
+    *count = n;
+    return 1;
+}
+
+/* Decode a parts file into its distinct parts in ascending order of value,
+ * with how many of each are stocked. Returns 0 if out of memory. */
+int build_inventory_parts(FILE* in, ResistorInfo** parts, unsigned long** stock,
+                          size_t* count) {
+    PartReport report;
+    ResistorInfo* list;
+    unsigned long* counts;
+    size_t i;
+    
+    if(!report_init(&report) || !build_part_report(in, &report) ||
+       !finish_part_report(&report, 0)) {
+        report_free(&report);
+        return 0;
+    }
+    
+    list = malloc((report.num_groups + 1) * sizeof(ResistorInfo));
+    counts = malloc((report.num_groups + 1) * sizeof(unsigned long));
+    if(list == NULL || counts == NULL) {
+        free(list);
+        free(counts);
+        report_free(&report);
+        return 0;
+    }
+    
+    /* Keys sort by value first, so the groups are already in order */
+    for(i = 0; i < report.num_groups; i++) {
+        list[i] = unpack_resistor_key(report.groups[i].key);
+        counts[i] = report.groups[i].count;
+    }
+    
+    *parts = list;
+    *stock = counts;
+    *count = report.num_groups;
+    report_free(&report);
+    return 1;
+}
+
+/* Write a part's tempco for the results table, "-" if it has no tempco band */
+static void format_tempco(int temp_coefficient, char* buffer, size_t size) {
+    if(temp_coefficient > 0) {
+        snprintf(buffer, size, "%d", temp_coefficient);
+    } else {
+        snprintf(buffer, size, "-");
+    }
+}
+
+/* Return 1 if a is below or equal to b, ignoring rounding noise */
+static int error_at_most(double a, double b) {
+    return a <= b + 1e-12 + 1e-9 * fmax(fabs(a), fabs(b));
+}
+
+/* Return 1 if pair a is at least as good as pair b on every measure.
+ * When they tie on every measure the pair with the lower R1 + R2 wins. */
+static int divider_dominates(const DividerPair* a, const DividerPair* b) {
+    double ea = fabs(a->ratio_error), eb = fabs(b->ratio_error);
+    
+    if(!error_at_most(ea, eb) || !error_at_most(a->worst_error, b->worst_error) ||
+       !error_at_most(a->tempco_drift, b->tempco_drift)) {
+        return 0;
+    }
+    if(error_at_most(eb, ea) && error_at_most(b->worst_error, a->worst_error) &&
+       error_at_most(b->tempco_drift, a->tempco_drift)) {
+        return a->r1.resistance + a->r2.resistance <= b->r1.resistance + b->r2.resistance;
+    }
+    return 1;
+}
+
+/* Add a pair to the Pareto front unless an existing pair is as good.
+ * Pairs it beats are removed. Returns 0 if out of memory. */
+static int add_to_front(DividerPair** front, size_t* count, size_t* capacity,
+                        const DividerPair* pair) {
+    size_t i, kept = 0;
+    
+    for(i = 0; i < *count; i++) {
+        if(divider_dominates(&(*front)[i], pair)) return 1;
+    }
+    for(i = 0; i < *count; i++) {
+        if(!divider_dominates(pair, &(*front)[i])) {
+            (*front)[kept++] = (*front)[i];
+        }
+    }
+    *count = kept;
+    
+    if(*count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+        DividerPair* grown = realloc(*front, new_capacity * sizeof(DividerPair));
+        if(grown == NULL) return 0;
+        *front = grown;
+        *capacity = new_capacity;
+    }
+    (*front)[(*count)++] = *pair;
+    return 1;
+}
+
+/* Work out the measures for R1/R2 and add it to the front if it qualifies */
+static int try_divider_pair(DividerPair** front, size_t* count, size_t* capacity,
+                            const ResistorInfo* r1, const ResistorInfo* r2,
+                            double target_ratio, double max_error,
+                            double min_total, double max_total) {
+    DividerPair pair;
+    double total = r1->resistance + r2->resistance;
+    double r1_min, r1_max, r2_min, r2_max, low, high;
+    int tc1, tc2;
+    
+    if(r2->resistance <= 0 || total < min_total || (max_total > 0 && total > max_total)) {
+        return 1;
+    }
+    
+    pair.ratio = r2->resistance / total;
+    pair.ratio_error = (pair.ratio - target_ratio) / target_ratio * 100.0;
+    if(fabs(pair.ratio_error) > max_error) return 1;
+    
+    /* The ratio is lowest with R1 high and R2 low, and highest the other way */
+    r1_min = r1->resistance * (1 - r1->tolerance / 100.0);
+    r1_max = r1->resistance * (1 + r1->tolerance / 100.0);
+    r2_min = r2->resistance * (1 - r2->tolerance / 100.0);
+    r2_max = r2->resistance * (1 + r2->tolerance / 100.0);
+    low = r2_min / (r1_max + r2_min);
+    high = r2_max / (r1_min + r2_max);
+    pair.worst_error = fmax(fabs(low - target_ratio), fabs(high - target_ratio))
+                       / target_ratio * 100.0;
+    
+    /* A tempco band only bounds the size of the drift, so in the worst case
+     * R1 and R2 drift in opposite directions; the ratio moves by (1 - ratio)
+     * times their sum. The target ratio is used so that pairs do not trade
+     * ratio error for a sliver of drift. Parts without a tempco band are
+     * assumed to be poor. */
+    tc1 = (r1->temp_coefficient > 0) ? r1->temp_coefficient : UNKNOWN_TEMPCO;
+    tc2 = (r2->temp_coefficient > 0) ? r2->temp_coefficient : UNKNOWN_TEMPCO;
+    pair.tempco_drift = (1 - target_ratio) * (tc1 + tc2);
+    
+    pair.r1 = *r1;
+    pair.r2 = *r2;
+    return add_to_front(front, count, capacity, &pair);
+}
+
+/* qsort comparator: smallest nominal error first, then worst-case error */
+static int compare_divider_error(const void* a, const void* b) {
+    const DividerPair* pa = (const DividerPair*)a;
+    const DividerPair* pb = (const DividerPair*)b;
+    double ea = fabs(pa->ratio_error), eb = fabs(pb->ratio_error);
+    
+    if(ea != eb) return (ea < eb) ? -1 : 1;
+    if(pa->worst_error != pb->worst_error) return (pa->worst_error < pb->worst_error) ? -1 : 1;
+    if(pa->tempco_drift != pb->tempco_drift) return (pa->tempco_drift < pb->tempco_drift) ? -1 : 1;
+    return 0;
+}
+
+/* Find the Pareto-optimal R1/R2 pairs for ratio = R2 / (R1 + R2), trading off
+ * nominal error, worst-case error and worst-case tempco drift. parts must be
+ * sorted by resistance. stock gives how many of each part there are, so a
+ * part is only paired with itself when at least two are stocked; NULL means
+ * unlimited stock. Only pairs within max_error (%) and with R1 + R2 between
+ * min_total and max_total (0 = no limit) are kept. Of pairs that tie on every
+ * measure (e.g. the same ratio one decade up) only the one with the lowest
+ * R1 + R2 is kept.
+ * The result is sorted by nominal error; the caller frees *pairs.
+ * Returns 0 for an invalid ratio or out of memory. */
+int search_divider_pairs(const ResistorInfo* parts, const unsigned long* stock,
+                         size_t count, double target_ratio,
+                         double max_error, double min_total, double max_total,
+                         DividerPair** pairs, size_t* num_pairs) {
+    DividerPair* front = NULL;
+    size_t front_count = 0, front_capacity = 0;
+    double low_ratio, high_ratio, low_scale, high_scale;
+    size_t i, j = 0, k;
+    
+    if(target_ratio <= 0 || target_ratio >= 1 || max_error < 0) return 0;
+    
+    /* R2 / R1 limits for the error budget, widened slightly for rounding
+     * (try_divider_pair() checks the exact error) */
+    low_ratio = target_ratio * (1 - max_error / 100.0);
+    high_ratio = target_ratio * (1 + max_error / 100.0);
+    low_scale = (low_ratio > 0) ? low_ratio / (1 - low_ratio) * (1 - 1e-9) : 0;
+    high_scale = (high_ratio < 1) ? high_ratio / (1 - high_ratio) * (1 + 1e-9) : HUGE_VAL;
+    
+    /* The R2 window moves up as R1 grows, so its start only ever advances */
+    for(i = 0; i < count; i++) {
+        if(parts[i].resistance <= 0) continue;
+        while(j < count && parts[j].resistance < parts[i].resistance * low_scale) j++;
+        
+        for(k = j; k < count && parts[k].resistance <= parts[i].resistance * high_scale; k++) {
+            if(k == i && stock != NULL && stock[i] < 2) continue;  /* Only one stocked */
+            if(!try_divider_pair(&front, &front_count, &front_capacity, &parts[i],
+                                 &parts[k], target_ratio, max_error,
+                                 min_total, max_total)) {
+                free(front);
+                return 0;
+            }
+        }
+    }
+    
+    if(front_count > 0) {
+        qsort(front, front_count, sizeof(DividerPair), compare_divider_error);
+    }
+    *pairs = front;
+    *num_pairs = front_count;
+    return 1;
+}
+
 /* ========== Menu Item Functions ========== */
 
 /* Menu Item 1: 4-Band Resistor Decoder */
@@ -541,3 +1910,405 @@ void menu_item_4(void) {
     
     encode_resistance_to_colors(resistance, tolerance, num_bands);
 }
+
+/* Menu Item 5: Batch Report from a Parts File */
+void menu_item_5(void) {
+    char path[256];
+    char input[100];
+    char res_buffer[50];
+    FILE* in;
+    FILE* out;
+    PartReport report;
+    ResistorInfo info;
+    char* end;
+    long count;
+    size_t top_n, i;
+    int use_json, d;
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║              BATCH REPORT FROM PARTS FILE                  ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("Each line of the parts file lists 4, 5 or 6 band colors,\n");
+    printf("e.g. \"brown black red gold\". Lines starting with '#' are skipped.\n\n");
+    
+    /* Get input file */
+    printf("Enter parts file path: ");
+    if(!fgets(path, sizeof(path), stdin)) return;
+    path[strcspn(path, "\r\n")] = '\0';
+    
+    in = fopen(path, "r");
+    if(in == NULL) {
+        printf("Error: Cannot open '%s'!\n", path);
+        return;
+    }
+    
+    /* Get number of top values */
+    printf("How many of the most common values to list? [10]: ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        fclose(in);
+        return;
+    }
+    if(input[0] == '\n' || input[0] == '\0') {
+        top_n = 10;
+    } else {
+        count = strtol(input, &end, 10);
+        while(isspace((unsigned char)*end)) end++;
+        if(end == input || *end != '\0' || count < 0) {
+            printf("Error: Count must be a whole number of 0 or more!\n");
+            fclose(in);
+            return;
+        }
+        top_n = (size_t)count;
+    }
+    
+    if(!report_init(&report) || !build_part_report(in, &report) ||
+       !finish_part_report(&report, top_n)) {
+        printf("Error: Cannot read '%s' or out of memory!\n", path);
+        fclose(in);
+        report_free(&report);
+        return;
+    }
+    fclose(in);
+    
+    /* Display summary */
+    printf("\nParts decoded:  %llu\n", report.total_parts);
+    printf("Invalid lines:  %llu\n", report.invalid_lines);
+    printf("Distinct parts: %lu\n", (unsigned long)report.num_groups);
+    
+    printf("\nMost Common Parts:\n");
+    printf("------------------\n");
+    for(i = 0; i < report.num_top; i++) {
+        info = unpack_resistor_key(report.top[i].key);
+        format_resistance(info.resistance, res_buffer, sizeof(res_buffer));
+        printf("%3lu. %-12s ±%5.2f%% ", (unsigned long)(i + 1), res_buffer, info.tolerance);
+        if(info.temp_coefficient > 0) {
+            printf("%3d ppm/K ", info.temp_coefficient);
+        } else {
+            printf("          ");
+        }
+        printf("x %lu\n", report.top[i].count);
+    }
+    
+    printf("\nParts per Decade:\n");
+    printf("-----------------\n");
+    for(d = 0; d < NUM_DECADES; d++) {
+        if(report.decade_counts[d] == 0) continue;
+        format_resistance(pow(10, d - 2), res_buffer, sizeof(res_buffer));
+        printf("  from %-12s %llu\n", res_buffer, report.decade_counts[d]);
+    }
+    
+    /* Get output format and file */
+    printf("\nReport format (csv/json, blank to skip): ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        report_free(&report);
+        return;
+    }
+    input[strcspn(input, "\r\n")] = '\0';
+    
+    if(input[0] == '\0') {
+        report_free(&report);
+        return;
+    }
+    if(strcmp(input, "csv") == 0) {
+        use_json = 0;
+    } else if(strcmp(input, "json") == 0) {
+        use_json = 1;
+    } else {
+        printf("Error: Format must be csv or json!\n");
+        report_free(&report);
+        return;
+    }
+    
+    printf("Enter output file path: ");
+    if(!fgets(path, sizeof(path), stdin)) {
+        report_free(&report);
+        return;
+    }
+    path[strcspn(path, "\r\n")] = '\0';
+    
+    out = fopen(path, "w");
+    if(out == NULL) {
+        printf("Error: Cannot create '%s'!\n", path);
+        report_free(&report);
+        return;
+    }
+    
+    if(use_json) {
+        write_report_json(out, &report);
+    } else {
+        write_report_csv(out, &report);
+    }
+    fclose(out);
+    printf("Report written to %s\n", path);
+    
+    report_free(&report);
+}
+
+/* Menu Item 6: Export a Parts File */
+void menu_item_6(void) {
+    char path[256];
+    char input[100];
+    FILE* in;
+    FILE* out;
+    PartWriter writer;
+    PipelineStats stats;
+    ExportFormat format;
+    int ok;
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                  EXPORT DECODED PARTS                      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("Decodes every line of a parts file and writes the results\n");
+    printf("in a format other tools can load directly.\n\n");
+    
+    /* Get input file */
+    printf("Enter parts file path: ");
+    if(!fgets(path, sizeof(path), stdin)) return;
+    path[strcspn(path, "\r\n")] = '\0';
+    
+    in = fopen(path, "r");
+    if(in == NULL) {
+        printf("Error: Cannot open '%s'!\n", path);
+        return;
+    }
+    
+    /* Get output format */
+    printf("Output format (csv/jsonl/columnar): ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        fclose(in);
+        return;
+    }
+    input[strcspn(input, "\r\n")] = '\0';
+    
+    if(strcmp(input, "csv") == 0) {
+        format = EXPORT_CSV;
+    } else if(strcmp(input, "jsonl") == 0) {
+        format = EXPORT_JSONL;
+    } else if(strcmp(input, "columnar") == 0) {
+        format = EXPORT_COLUMNAR;
+    } else {
+        printf("Error: Format must be csv, jsonl or columnar!\n");
+        fclose(in);
+        return;
+    }
+    
+    /* Get output file */
+    printf("Enter output file path: ");
+    if(!fgets(path, sizeof(path), stdin)) {
+        fclose(in);
+        return;
+    }
+    path[strcspn(path, "\r\n")] = '\0';
+    
+    out = fopen(path, (format == EXPORT_COLUMNAR) ? "wb" : "w");
+    if(out == NULL) {
+        printf("Error: Cannot create '%s'!\n", path);
+        fclose(in);
+        return;
+    }
+    
+    if(!part_writer_open(&writer, out, format, PIPELINE_BATCH_PARTS)) {
+        printf("Error: Cannot start writing '%s'!\n", path);
+        fclose(in);
+        fclose(out);
+        return;
+    }
+    
+    ok = run_export_pipeline(in, &writer, &stats);
+    
+    if(!part_writer_close(&writer)) ok = 0;
+    fclose(in);
+    if(fclose(out) != 0) ok = 0;
+    
+    if(!ok) {
+        printf("Error: Failed while exporting to '%s'!\n", path);
+        return;
+    }
+    
+    printf("\nParts exported: %llu\n", writer.rows);
+    printf("Invalid lines:  %llu\n", stats.invalid_lines);
+    printf("Output written to %s\n", path);
+    print_pipeline_stats(&stats);
+}
+
+/* Menu Item 7: Voltage Divider Search */
+void menu_item_7(void) {
+    char input[256];
+    char r1_buffer[50], r2_buffer[50];
+    char tc1_buffer[8], tc2_buffer[8];
+    ResistorInfo* parts = NULL;
+    unsigned long* stock = NULL;  /* Stays NULL (unlimited) for an E-series */
+    DividerPair* pairs = NULL;
+    size_t num_parts = 0, num_pairs = 0, i;
+    double target_ratio, max_error, min_total, max_total;
+    clock_t start;
+    double elapsed_ms;
+    
+    printf("\n╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                 VOLTAGE DIVIDER SEARCH                     ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    
+    printf("Finds R1/R2 pairs for Vout/Vin = R2 / (R1 + R2).\n\n");
+    
+    /* Get the source of resistor values */
+    printf("Search an E-series or an inventory parts file? (e/i): ");
+    if(!fgets(input, sizeof(input), stdin)) return;
+    
+    if(input[0] == 'e' || input[0] == 'E') {
+        int series;
+        ColorCode tolerance, temp_coeff = NONE;
+        
+        printf("Enter E-series (6, 12, 24, 48, 96, 192): ");
+        if(!fgets(input, sizeof(input), stdin)) return;
+        series = atoi(input);
+        
+        /* Default tolerance is the one the series is made for */
+        switch(series) {
+            case 6:   tolerance = NONE;   break;
+            case 12:  tolerance = SILVER; break;
+            case 24:  tolerance = GOLD;   break;
+            case 48:  tolerance = RED;    break;
+            case 96:  tolerance = BROWN;  break;
+            case 192: tolerance = GREEN;  break;
+            default:
+                printf("Error: Unknown E-series!\n");
+                return;
+        }
+        
+        printf("Tolerance band color [%s]: ", get_color_name(tolerance));
+        if(!fgets(input, sizeof(input), stdin)) return;
+        input[strcspn(input, "\r\n")] = '\0';
+        if(input[0] != '\0') {
+            tolerance = get_color_from_input(input);
+            if(get_tolerance(tolerance) < 0) {
+                printf("Error: Invalid tolerance color!\n");
+                return;
+            }
+        }
+        
+        printf("Tempco band color (blank for none): ");
+        if(!fgets(input, sizeof(input), stdin)) return;
+        input[strcspn(input, "\r\n")] = '\0';
+        if(input[0] != '\0') {
+            temp_coeff = get_color_from_input(input);
+            if(get_temp_coefficient(temp_coeff) < 0) {
+                printf("Error: Invalid tempco color!\n");
+                return;
+            }
+        }
+        
+        if(!build_eseries_parts(series, tolerance, temp_coeff, &parts, &num_parts)) {
+            printf("Error: Out of memory!\n");
+            return;
+        }
+    } else if(input[0] == 'i' || input[0] == 'I') {
+        FILE* in;
+        
+        printf("Enter parts file path: ");
+        if(!fgets(input, sizeof(input), stdin)) return;
+        input[strcspn(input, "\r\n")] = '\0';
+        
+        in = fopen(input, "r");
+        if(in == NULL) {
+            printf("Error: Cannot open '%s'!\n", input);
+            return;
+        }
+        if(!build_inventory_parts(in, &parts, &stock, &num_parts)) {
+            printf("Error: Out of memory!\n");
+            fclose(in);
+            return;
+        }
+        fclose(in);
+    } else {
+        printf("Error: Enter 'e' or 'i'!\n");
+        return;
+    }
+    
+    /* Get search limits */
+    printf("Enter target ratio Vout/Vin (between 0 and 1): ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        free(parts);
+        free(stock);
+        return;
+    }
+    target_ratio = atof(input);
+    if(target_ratio <= 0 || target_ratio >= 1) {
+        printf("Error: Ratio must be between 0 and 1!\n");
+        free(parts);
+        free(stock);
+        return;
+    }
+    
+    printf("Enter maximum ratio error (%%) [1]: ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        free(parts);
+        free(stock);
+        return;
+    }
+    max_error = (input[0] == '\n' || input[0] == '\0') ? 1.0 : atof(input);
+    if(max_error < 0) {
+        printf("Error: Maximum ratio error cannot be negative!\n");
+        free(parts);
+        free(stock);
+        return;
+    }
+    
+    /* Without a floor, ties across decades all resolve to the 1 Ω decade,
+     * which is no use as a feedback or ADC divider */
+    printf("Enter minimum R1 + R2 in ohms [%d]: ", DEFAULT_MIN_TOTAL);
+    if(!fgets(input, sizeof(input), stdin)) {
+        free(parts);
+        free(stock);
+        return;
+    }
+    min_total = (input[0] == '\n' || input[0] == '\0') ? DEFAULT_MIN_TOTAL : atof(input);
+    
+    printf("Enter maximum R1 + R2 in ohms (0 for no limit) [0]: ");
+    if(!fgets(input, sizeof(input), stdin)) {
+        free(parts);
+        free(stock);
+        return;
+    }
+    max_total = atof(input);
+    
+    start = clock();
+    if(!search_divider_pairs(parts, stock, num_parts, target_ratio, max_error,
+                             min_total, max_total, &pairs, &num_pairs)) {
+        printf("Error: Out of memory!\n");
+        free(parts);
+        free(stock);
+        return;
+    }
+    elapsed_ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    
+    /* Display results */
+    printf("\nSearched %lu values in %.2f ms, %lu best pair(s):\n\n",
+           (unsigned long)num_parts, elapsed_ms, (unsigned long)num_pairs);
+    
+    if(num_pairs > 0) {
+        printf("  R1            R2            Ratio      Error     Worst    TC1  TC2  Drift (ppm/K)\n");
+        printf("  ------------  ------------  ---------  --------  -------  ---  ---  -------------\n");
+    }
+    for(i = 0; i < num_pairs; i++) {
+        format_resistance(pairs[i].r1.resistance, r1_buffer, sizeof(r1_buffer));
+        format_resistance(pairs[i].r2.resistance, r2_buffer, sizeof(r2_buffer));
+        format_tempco(pairs[i].r1.temp_coefficient, tc1_buffer, sizeof(tc1_buffer));
+        format_tempco(pairs[i].r2.temp_coefficient, tc2_buffer, sizeof(tc2_buffer));
+        printf("  %-12s  %-12s  %.6f  %+7.4f%%  %6.3f%%  %3s  %3s  %13.1f\n",
+               r1_buffer, r2_buffer, pairs[i].ratio, pairs[i].ratio_error,
+               pairs[i].worst_error, tc1_buffer, tc2_buffer, pairs[i].tempco_drift);
+    }
+    if(num_pairs > 0) {
+        printf("\nTC is each part's tempco band (- = none, assumed %d ppm/K).\n", UNKNOWN_TEMPCO);
+        printf("Drift is the worst-case change of the ratio per kelvin.\n");
+    }
+    if(num_pairs == 0) {
+        printf("No pair is within the error budget. Try a larger budget or series.\n");
+    }
+    
+    free(pairs);
+    free(parts);
+    free(stock);
+}
@@ -1,6 +1,8 @@
 #ifndef FUNCS_H
 #define FUNCS_H
 
+#include <stdio.h>
+
 /* Color definitions for resistor bands */
 typedef enum {
     BLACK = 0,
@@ -37,11 +39,133 @@ typedef struct {
     int num_bands;         /* Number of color bands */
 } ResistorInfo;
 
+/* Number of resistance decades covered by reports (0.01 Ω up to 1 TΩ) */
+#define NUM_DECADES 14
+
+/* One distinct part (value/tolerance/tempco) and how often it was seen */
+typedef struct {
+    unsigned long long key;   /* Packed resistor key, see pack_resistor_key() */
+    unsigned long count;      /* Number of parts with this key (0 = empty slot) */
+} PartGroup;
+
+/* Aggregated summary of a stream of decoded parts */
+typedef struct {
+    PartGroup* slots;         /* Open-addressing hash table of distinct parts */
+    size_t capacity;          /* Number of slots (power of two) */
+    size_t used;              /* Number of occupied slots */
+    unsigned long long total_parts;    /* Parts decoded successfully */
+    unsigned long long invalid_lines;  /* Lines that could not be decoded */
+    unsigned long long decade_counts[NUM_DECADES];
+    PartGroup* groups;        /* Distinct parts sorted by key (after finish) */
+    size_t num_groups;
+    PartGroup* top;           /* Most common parts, highest count first */
+    size_t num_top;
+} PartReport;
+
+/* One block of arena memory; blocks are kept for reuse after a reset */
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size;              /* Bytes available in data */
+    size_t used;              /* Bytes handed out since the last reset */
+    unsigned char data[];
+} ArenaBlock;
+
+/* Bump allocator for short-lived records, freed all at once by arena_reset() */
+typedef struct {
+    ArenaBlock* first;        /* All blocks, in the order they are filled */
+    ArenaBlock* current;      /* Block allocations are taken from */
+    size_t block_size;        /* Default size of new blocks */
+    unsigned long long allocations;       /* arena_alloc() calls, lifetime */
+    unsigned long long resets;            /* arena_reset() calls */
+    unsigned long long heap_allocations;  /* Blocks taken from malloc() */
+    size_t bytes_in_use;      /* Bytes handed out since the last reset */
+    size_t peak_bytes;        /* Highest bytes_in_use seen */
+    size_t reserved_bytes;    /* Total size of all blocks */
+} Arena;
+
+/* A batch of successfully decoded parts */
+typedef struct {
+    ResistorInfo* parts;
+    size_t count;
+    size_t capacity;
+    unsigned long long invalid_lines;  /* Lines skipped while filling the batch */
+} PartBatch;
+
+/* Output formats for exported parts */
+typedef enum {
+    EXPORT_CSV = 0,
+    EXPORT_JSONL,
+    EXPORT_COLUMNAR
+} ExportFormat;
+
+/* Buffered writer for decoded parts.
+ * The columnar format starts with the 4 bytes "RCOL" and a uint32 version,
+ * followed by one block per batch: a uint32 row count, then the resistance,
+ * tolerance, tempco (int32), minimum and maximum columns as contiguous arrays
+ * in native byte order. A block with a row count of 0 ends the file. */
+typedef struct {
+    FILE* out;
+    ExportFormat format;
+    char* buffer;             /* Text output buffer (CSV / JSON Lines) */
+    size_t length;            /* Bytes currently held in buffer */
+    size_t size;              /* Capacity of buffer */
+    double* columns;          /* Column scratch for one batch (columnar) */
+    int* tempcos;
+    size_t column_capacity;
+    unsigned long long rows;  /* Rows written so far */
+} PartWriter;
+
+/* Bytes of the parts file read per pipeline chunk, and the most parts a
+ * chunk can hold (the shortest valid line, "red red red red", is 16 bytes) */
+#define PIPELINE_CHUNK_SIZE (256 * 1024)
+#define PIPELINE_MAX_PARTS (PIPELINE_CHUNK_SIZE / 16 + 1)
+
+/* Parts per batch; a chunk is decoded into as many batches as it needs */
+#define PIPELINE_BATCH_PARTS 1024
+
+/* Stages of the export pipeline */
+typedef enum {
+    STAGE_READ = 0,
+    STAGE_DECODE,
+    STAGE_WRITE,
+    NUM_STAGES
+} PipelineStage;
+
+/* Timing and counts from one run of the export pipeline */
+typedef struct {
+    int threads;              /* Threads the stages ran on (1 to NUM_STAGES) */
+    double wall_ms;           /* Time for the whole run */
+    double busy_ms[NUM_STAGES];   /* Time each stage spent working */
+    double wait_ms[NUM_STAGES];   /* Time each stage spent waiting for a chunk */
+    unsigned long long chunks;
+    unsigned long long bytes_read;
+    unsigned long long parts;
+    unsigned long long invalid_lines;
+    unsigned long long arena_allocations; /* arena_alloc() calls, all slots */
+    unsigned long long arena_resets;      /* arena_reset() calls, all slots */
+    unsigned long long heap_allocations;  /* Arena blocks taken from malloc() */
+    size_t peak_arena_bytes;  /* Largest arena use of any slot */
+    size_t reserved_arena_bytes;  /* Size of all arena blocks, all slots */
+} PipelineStats;
+
+/* A candidate R1/R2 voltage divider, ratio = R2 / (R1 + R2) */
+typedef struct {
+    ResistorInfo r1;          /* Top resistor */
+    ResistorInfo r2;          /* Bottom resistor */
+    double ratio;             /* Nominal ratio */
+    double ratio_error;       /* Nominal ratio error (%) */
+    double worst_error;       /* Worst-case ratio error over tolerances (%) */
+    double tempco_drift;      /* Worst-case ratio drift (ppm/K) */
+} DividerPair;
+
 /* Menu item functions */
 void menu_item_1(void);  /* 4-band resistor decoder */
 void menu_item_2(void);  /* 5-band resistor decoder */
 void menu_item_3(void);  /* 6-band resistor decoder */
 void menu_item_4(void);  /* Resistance to color bands converter */
+void menu_item_5(void);  /* Batch report from a parts file */
+void menu_item_6(void);  /* Export a parts file as CSV / JSON Lines / columnar */
+void menu_item_7(void);  /* Voltage divider search */
 
 /* Helper functions */
 const char* get_color_name(ColorCode color);
@@ -70,5 +194,49 @@ void print_resistor_info(ResistorInfo info);
 void print_color_table(void);
 int get_color_input(const char* prompt, ColorCode* color, int band_num, int total_bands);
 
+/* Batch report functions.
+ * A parts file holds one resistor per line as 4, 5 or 6 color names separated
+ * by spaces, tabs or commas (e.g. "brown black red gold"). Blank lines and
+ * anything after '#' are ignored. */
+int decode_part_line(const char* line, ResistorInfo* info);
+unsigned long long pack_resistor_key(ResistorInfo info);
+ResistorInfo unpack_resistor_key(unsigned long long key);
+int get_decade_index(unsigned long long key);
+void radix_sort_groups(PartGroup* groups, PartGroup* scratch, size_t n);
+int report_init(PartReport* report);
+int report_add(PartReport* report, ResistorInfo info);
+int report_merge(PartReport* into, const PartReport* from);
+int build_part_report(FILE* in, PartReport* report);
+int finish_part_report(PartReport* report, size_t top_n);
+void report_free(PartReport* report);
+void write_report_csv(FILE* out, const PartReport* report);
+void write_report_json(FILE* out, const PartReport* report);
+
+/* Arena functions */
+void arena_init(Arena* arena, size_t block_size);
+void* arena_alloc(Arena* arena, size_t size);
+void arena_reset(Arena* arena);
+void arena_free(Arena* arena);
+
+/* Export functions */
+int part_batch_init(PartBatch* batch, Arena* arena, size_t capacity);
+int part_writer_open(PartWriter* writer, FILE* out, ExportFormat format, size_t batch_capacity);
+int part_writer_write_batch(PartWriter* writer, const PartBatch* batch);
+int part_writer_close(PartWriter* writer);
+
+/* Pipeline functions */
+int run_export_pipeline(FILE* in, PartWriter* writer, PipelineStats* stats);
+void print_pipeline_stats(const PipelineStats* stats);
+
+/* Divider search functions */
+int build_eseries_parts(int series, ColorCode tolerance, ColorCode temp_coeff,
+                        ResistorInfo** parts, size_t* count);
+int build_inventory_parts(FILE* in, ResistorInfo** parts, unsigned long** stock,
+                          size_t* count);
+int search_divider_pairs(const ResistorInfo* parts, const unsigned long* stock,
+                         size_t count, double target_ratio,
+                         double max_error, double min_total, double max_total,
+                         DividerPair** pairs, size_t* num_pairs);
+
 #endif
 
@@ -37,7 +37,7 @@ static void main_menu(void)
 
 static int get_user_input(void)
 {
-    enum { MENU_ITEMS = 5 };   /* 1..4 = items, 5 = Exit */
+    enum { MENU_ITEMS = 8 };   /* 1..7 = items, 8 = Exit */
     char buf[128];
     int valid_input = 0;
     int value = 0;
@@ -89,6 +89,18 @@ static void select_menu_item(int input)
             menu_item_4();
             go_back_to_main();
             break;
+        case 5:
+            menu_item_5();
+            go_back_to_main();
+            break;
+        case 6:
+            menu_item_6();
+            go_back_to_main();
+            break;
+        case 7:
+            menu_item_7();
+            go_back_to_main();
+            break;
         default:
             printf("Bye!\n");
             exit(0);
@@ -104,7 +116,10 @@ static void print_main_menu(void)
            "\t2. Decode 5-band resistor (colour → value)\t\t\n"
            "\t3. Decode 6-band resistor (colour → value + tempco)\t\t\n"
            "\t4. Encode resistance value into colour bands\t\t\n"
-           "\t5. Exit\t\t\t\t\n"
+           "\t5. Batch report from parts file (counts, top values, decades)\t\t\n"
+           "\t6. Export parts file (CSV / JSON Lines / columnar)\t\t\n"
+           "\t7. Voltage divider search (R1/R2 pairs for a ratio)\t\t\n"
+           "\t8. Exit\t\t\t\t\n"
            "\t\t\t\t\t\t\n");
     printf("---------------------------------------------\n");
 }